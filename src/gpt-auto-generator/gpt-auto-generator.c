@@ -1,5 +1,6 @@
 /* SPDX-License-Identifier: LGPL-2.1-or-later */
 
+#include <fcntl.h>
 #include <stdlib.h>
 #include <sys/file.h>
 #include <unistd.h>
@@ -60,8 +61,9 @@ static int add_cryptsetup(
                 char **ret_device) {
 
 #if HAVE_LIBCRYPTSETUP
-        _cleanup_free_ char *e = NULL, *n = NULL, *d = NULL, *options = NULL;
+        _cleanup_free_ char *escaped = NULL, *n = NULL, *d = NULL, *options = NULL;
         _cleanup_fclose_ FILE *f = NULL;
+        const char *e;
         int r;
 
         assert(id);
@@ -71,9 +73,17 @@ static int add_cryptsetup(
         if (r < 0)
                 return log_error_errno(r, "Failed to generate unit name: %m");
 
-        e = unit_name_escape(id);
-        if (!e)
-                return log_oom();
+        /* The ids we are passed are short fixed tokens such as "root" or "swap", which are their own
+         * escaping. Detect that and avoid the extra pass and allocation then. */
+        if (id[0] != '.' && in_charset(id, LETTERS DIGITS ":_"))
+                e = id;
+        else {
+                escaped = unit_name_escape(id);
+                if (!escaped)
+                        return log_oom();
+
+                e = escaped;
+        }
 
         r = unit_name_build("systemd-cryptsetup", e, ".service", &n);
         if (r < 0)
@@ -275,29 +285,39 @@ static int add_mount(
 }
 
 static int path_is_busy(const char *where) {
+        _cleanup_close_ int fd = -EBADF;
         int r;
 
         assert(where);
 
-        /* already a mountpoint; generators run during reload */
-        r = path_is_mount_point_full(where, /* root = */ NULL, AT_SYMLINK_FOLLOW);
-        if (r > 0)
-                return false;
-        /* The directory will be created by the mount or automount unit when it is started. */
-        if (r == -ENOENT)
-                return false;
+        /* Open the directory once, and do both the mount point and the emptiness check on the fd, instead
+         * of resolving the path separately for each of them. */
+        fd = open(where, O_DIRECTORY|O_RDONLY|O_CLOEXEC);
+        if (fd < 0) {
+                /* The directory will be created by the mount or automount unit when it is started. */
+                if (errno == ENOENT)
+                        return false;
+
+                if (errno == ENOTDIR) {
+                        log_debug("\"%s\" is not a directory, ignoring.", where);
+                        return true;
+                }
 
+                return log_warning_errno(errno, "Cannot open \"%s\": %m", where);
+        }
+
+        /* already a mountpoint; generators run during reload */
+        r = fd_is_mount_point(fd, /* filename= */ NULL, 0);
         if (r < 0)
                 return log_warning_errno(r, "Cannot check if \"%s\" is a mount point: %m", where);
+        if (r > 0)
+                return false;
 
         /* not a mountpoint but it contains files */
-        r = dir_is_empty(where, /* ignore_hidden_or_backup= */ false);
-        if (r == -ENOTDIR) {
-                log_debug("\"%s\" is not a directory, ignoring.", where);
-                return true;
-        } else if (r < 0)
+        r = dir_is_empty_at(fd, /* path= */ NULL, /* ignore_hidden_or_backup= */ false);
+        if (r < 0)
                 return log_warning_errno(r, "Cannot check if \"%s\" is empty: %m", where);
-        else if (r == 0) {
+        if (r == 0) {
                 log_debug("\"%s\" already populated, ignoring.", where);
                 return true;
         }
@@ -383,10 +403,9 @@ static int add_partition_swap(DissectedPartition *p) {
         if (r < 0)
                 return r;
 
-        fprintf(f,
-                "[Unit]\n"
-                "Description=Swap Partition\n"
-                "Documentation=man:systemd-gpt-auto-generator(8)\n");
+        fputs("[Unit]\n"
+              "Description=Swap Partition\n"
+              "Documentation=man:systemd-gpt-auto-generator(8)\n", f);
 
         r = generator_write_blockdev_dependency(f, what);
         if (r < 0)
@@ -666,9 +685,29 @@ static int add_root_cryptsetup(void) {
 }
 #endif
 
+static int loader_partition_uuid(sd_id128_t *ret) {
+        static sd_id128_t cached_uuid;
+        static int cached = 0;
+        static bool valid = false;
+
+        /* Both the root mount logic and the loader partition logic want LoaderDevicePartUUID. Read and
+         * parse the EFI variable only once per invocation, and hand out the cached result after that. */
+
+        if (!valid) {
+                cached = efi_loader_get_device_part_uuid(&cached_uuid);
+                valid = true;
+        }
+
+        if (cached >= 0 && ret)
+                *ret = cached_uuid;
+
+        return cached;
+}
+
 static int add_root_mount(void) {
 #if ENABLE_EFI
         _cleanup_free_ char *options = NULL;
+        bool initrd;
         int r;
 
         if (!is_efi_boot()) {
@@ -676,7 +715,7 @@ static int add_root_mount(void) {
                 return 0;
         }
 
-        r = efi_loader_get_device_part_uuid(NULL);
+        r = loader_partition_uuid(NULL);
         if (r == -ENOENT) {
                 log_notice("EFI loader partition unknown, exiting.\n"
                            "(The boot loader did not set EFI variable LoaderDevicePartUUID.)");
@@ -687,7 +726,8 @@ static int add_root_mount(void) {
         /* OK, we have an ESP/XBOOTLDR partition, this is fantastic, so let's wait for a root device to show up.
          * A udev rule will create the link for us under the right name. */
 
-        if (in_initrd()) {
+        initrd = in_initrd();
+        if (initrd) {
                 r = generator_write_initrd_root_device_deps(arg_dest, "/dev/gpt-auto-root");
                 if (r < 0)
                         return 0;
@@ -718,14 +758,14 @@ static int add_root_mount(void) {
         return add_mount(
                         "root",
                         "/dev/gpt-auto-root",
-                        in_initrd() ? "/sysroot" : "/",
+                        initrd ? "/sysroot" : "/",
                         arg_root_fstype,
                         /* rw= */ arg_root_rw > 0,
                         /* growfs= */ false,
                         /* measure= */ true,
                         options,
                         "Root Partition",
-                        in_initrd() ? SPECIAL_INITRD_ROOT_FS_TARGET : SPECIAL_LOCAL_FS_TARGET);
+                        initrd ? SPECIAL_INITRD_ROOT_FS_TARGET : SPECIAL_LOCAL_FS_TARGET);
 #else
         return 0;
 #endif
@@ -759,7 +799,7 @@ static int process_loader_partitions(DissectedPartition *esp, DissectedPartition
          * to the ESP, but we accept XBOOTLDR too. If it points to neither of them, don't mount any
          * loader partitions, since they are not the ones used for booting. */
 
-        r = efi_loader_get_device_part_uuid(&loader_uuid);
+        r = loader_partition_uuid(&loader_uuid);
         if (r == -ENOENT) {
                 log_debug_errno(r, "EFI loader partition unknown, skipping ESP and XBOOTLDR mounts.");
                 return 0;
@@ -955,7 +995,7 @@ static int parse_proc_cmdline_item(const char *key, const char *value, void *dat
 }
 
 static int run(const char *dest, const char *dest_early, const char *dest_late) {
-        int r, k;
+        int r;
 
         assert_se(arg_dest = dest_late);
 
@@ -973,14 +1013,10 @@ static int run(const char *dest, const char *dest_early, const char *dest_late)
                 return 0;
         }
 
-        if (arg_root_enabled)
-                r = add_root_mount();
+        r = arg_root_enabled ? add_root_mount() : 0;
 
-        if (!in_initrd()) {
-                k = add_mounts();
-                if (r >= 0)
-                        r = k;
-        }
+        if (!in_initrd())
+                RET_GATHER(r, add_mounts());
 
         return r;
 }
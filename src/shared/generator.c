@@ -122,19 +122,28 @@ int generator_add_symlink_full(
                 if (!from)
                         return log_oom();
 
-                to = strjoin(dir, "/", dst, ".", dep_type, "/", instantiated ?: fn);
+                const char *w = strjoina(dir, "/", dst, ".", dep_type);
+
+                /* <dir> already exists when we are invoked, hence the dependency directory is at most one
+                 * level away from an existing directory. Create it directly instead of re-checking the
+                 * whole chain of parents, and only fall back to that if the assumption turns out wrong. */
+                r = mkdir_label(w, 0755);
+                if (r == -ENOENT)
+                        (void) mkdir_p_label(w, 0755);
+
+                to = path_join(w, instantiated ?: fn);
         } else { /* or create an alias */
                 from = dn ? path_join(dn, fn) : strdup(fn);
                 if (!from)
                         return log_oom();
 
                 to = strjoin(dir, "/", dst);
+                if (to)
+                        (void) mkdir_parents_label(to, 0755);
         }
         if (!to)
                 return log_oom();
 
-        (void) mkdir_parents_label(to, 0755);
-
         if (symlink(from, to) < 0 && errno != EEXIST)
                 return log_error_errno(errno, "Failed to create symlink \"%s\": %m", to);
 
@@ -816,21 +825,19 @@ int generator_write_cryptsetup_unit_section(
 
         assert(f);
 
-        fprintf(f,
-                "[Unit]\n"
-                "Description=Cryptography Setup for %%I\n"
-                "Documentation=man:crypttab(5) man:systemd-cryptsetup-generator(8) man:systemd-cryptsetup@.service(8)\n");
+        fputs("[Unit]\n"
+              "Description=Cryptography Setup for %I\n"
+              "Documentation=man:crypttab(5) man:systemd-cryptsetup-generator(8) man:systemd-cryptsetup@.service(8)\n", f);
 
         if (source)
                 fprintf(f, "SourcePath=%s\n", source);
 
-        fprintf(f,
-                "\n"
-                "DefaultDependencies=no\n"
-                "After=cryptsetup-pre.target systemd-udevd-kernel.socket systemd-tpm2-setup-early.service\n"
-                "Before=blockdev@dev-mapper-%%i.target\n"
-                "Wants=blockdev@dev-mapper-%%i.target\n"
-                "IgnoreOnIsolate=true\n");
+        fputs("\n"
+              "DefaultDependencies=no\n"
+              "After=cryptsetup-pre.target systemd-udevd-kernel.socket systemd-tpm2-setup-early.service\n"
+              "Before=blockdev@dev-mapper-%i.target\n"
+              "Wants=blockdev@dev-mapper-%i.target\n"
+              "IgnoreOnIsolate=true\n", f);
 
         return 0;
 }
@@ -891,20 +898,18 @@ int generator_write_veritysetup_unit_section(
 
         assert(f);
 
-        fprintf(f,
-                "[Unit]\n"
-                "Description=Integrity Protection Setup for %%I\n"
-                "Documentation=man:veritytab(5) man:systemd-veritysetup-generator(8) man:systemd-veritysetup@.service(8)\n");
+        fputs("[Unit]\n"
+              "Description=Integrity Protection Setup for %I\n"
+              "Documentation=man:veritytab(5) man:systemd-veritysetup-generator(8) man:systemd-veritysetup@.service(8)\n", f);
 
         if (source)
                 fprintf(f, "SourcePath=%s\n", source);
 
-        fprintf(f,
-                "DefaultDependencies=no\n"
-                "IgnoreOnIsolate=true\n"
-                "After=veritysetup-pre.target systemd-udevd-kernel.socket\n"
-                "Before=blockdev@dev-mapper-%%i.target\n"
-                "Wants=blockdev@dev-mapper-%%i.target\n");
+        fputs("DefaultDependencies=no\n"
+              "IgnoreOnIsolate=true\n"
+              "After=veritysetup-pre.target systemd-udevd-kernel.socket\n"
+              "Before=blockdev@dev-mapper-%i.target\n"
+              "Wants=blockdev@dev-mapper-%i.target\n", f);
 
         return 0;
 }